@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Check that server CPU stays flat as viewers are added to the shared audio.
+
+Audio is encoded once; each viewer should only add a queue and SRTP for its
+packets. This connects headless viewers one at a time, measures the server's
+CPU (process_cpu_seconds_total rate) at each count and fails if any viewer
+adds more than --per-viewer-budget cores, or if a viewer did not get an
+audio branch.
+
+    ./Vadd --device=test --audio=test --connect-interval=0
+    tests/audio_cpu_scaling.py --viewers 8
+"""
+
+import argparse
+import sys
+import time
+
+from gi.repository import GLib
+
+from gst_viewer import Viewer
+from harness import fetch_metrics
+
+
+def run_loop(seconds):
+    loop = GLib.MainLoop()
+    GLib.timeout_add(int(seconds * 1000), loop.quit)
+    loop.run()
+
+
+def cpu_rate(host, port, window):
+    start = fetch_metrics(host, port)["process_cpu_seconds_total"]
+    started = time.monotonic()
+    run_loop(window)
+    return (fetch_metrics(host, port)["process_cpu_seconds_total"] - start) / (time.monotonic() - started)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--viewers", type=int, default=8)
+    parser.add_argument("--window", type=float, default=10.0, help="seconds of CPU sampling per step")
+    parser.add_argument("--settle", type=float, default=5.0, help="seconds for a new viewer to start streaming")
+    parser.add_argument("--per-viewer-budget", type=float, default=0.05,
+                        help="CPU cores a single extra viewer may add")
+    args = parser.parse_args()
+
+    baseline = cpu_rate(args.host, args.port, args.window)
+    print(f"0 viewers: {baseline:.3f} cores")
+
+    viewers = []
+    rates = [baseline]
+    errors = []
+    for count in range(1, args.viewers + 1):
+        viewers.append(Viewer(args.host, args.port))
+        run_loop(args.settle)
+        rates.append(cpu_rate(args.host, args.port, args.window))
+        audio_viewers = fetch_metrics(args.host, args.port).get("webrtc_audio_viewers", 0)
+        print(f"{count} viewers: {rates[-1]:.3f} cores (+{rates[-1] - rates[-2]:.3f}), "
+              f"{audio_viewers:.0f} audio branches")
+        if audio_viewers < count:
+            errors.append(f"{count} viewers but {audio_viewers:.0f} audio branches")
+
+    for viewer in viewers:
+        viewer.close()
+
+    # The first viewer also starts SRTP and the UDP path; compare the marginal cost after it
+    if args.viewers > 1:
+        marginal = (rates[-1] - rates[1]) / (args.viewers - 1)
+        print(f"marginal cost per viewer: {marginal:.3f} cores")
+        if marginal > args.per_viewer_budget:
+            errors.append(f"each viewer adds {marginal:.3f} cores, budget {args.per_viewer_budget:.3f}")
+
+    for error in errors:
+        print(f"FAIL: {error}", file=sys.stderr)
+    if not errors:
+        print("PASS")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Sample capture timing from /metrics for a with/without pinning comparison.
+
+Run the server once without and once with --capture-cpus/--rt-priority under
+the same load (same viewer count, same background stress), and run this
+script against each for the same duration:
+
+    ./Vadd                                        # run A
+    ./Vadd --capture-cpus=2-3 --rt-priority=50    # run B
+    tests/capture_jitter.py --duration 300 --label unpinned
+    tests/capture_jitter.py --duration 300 --label pinned
+
+Prints one line per run: smoothed jitter (mean and worst of the samples), the
+largest frame interval and the late-frame rate over the sampling window.
+"""
+
+import argparse
+import time
+
+from harness import fetch_metrics
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--duration", type=float, default=120.0)
+    parser.add_argument("--interval", type=float, default=1.0)
+    parser.add_argument("--label", default="run")
+    args = parser.parse_args()
+
+    first = fetch_metrics(args.host, args.port)
+    jitter = []
+    deadline = time.monotonic() + args.duration
+    while time.monotonic() < deadline:
+        time.sleep(args.interval)
+        jitter.append(fetch_metrics(args.host, args.port)["webrtc_capture_jitter_seconds"])
+    last = fetch_metrics(args.host, args.port)
+
+    late = last["webrtc_capture_late_frames_total"] - first["webrtc_capture_late_frames_total"]
+    print(f"{args.label}: jitter mean {1000 * sum(jitter) / len(jitter):.3f} ms, "
+          f"worst {1000 * max(jitter):.3f} ms, "
+          f"max interval {1000 * last['webrtc_capture_interval_max_seconds']:.1f} ms (since start), "
+          f"late frames {late:.0f} ({late / args.duration:.2f}/s), "
+          f"viewers {last['webrtc_viewers']:.0f}")
+
+
+if __name__ == "__main__":
+    main()
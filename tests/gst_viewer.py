@@ -0,0 +1,146 @@
+"""Headless WebRTC viewer built on webrtcbin, for the scripts in this directory.
+
+Speaks the server's signaling protocol (offer from the server, answer and
+ice-candidate from the viewer), hands every received RTP buffer to a
+callback and exposes the server's DataChannels. Needs PyGObject and the
+GStreamer webrtc, nice, dtls and srtp plugins.
+"""
+
+import json
+import threading
+
+import gi
+
+gi.require_version("Gst", "1.0")
+gi.require_version("GstSdp", "1.0")
+gi.require_version("GstWebRTC", "1.0")
+from gi.repository import GLib, Gst, GstSdp, GstWebRTC  # noqa: E402
+
+from harness import WebSocket  # noqa: E402
+
+Gst.init(None)
+
+NTP_UNIX_EPOCH_OFFSET = 2208988800
+
+
+def rtp_extension(data, ext_id):
+    """Return the payload of one-byte header extension ext_id, or None."""
+    if len(data) < 12 or not data[0] & 0x10:
+        return None
+    offset = 12 + 4 * (data[0] & 0x0F)
+    if len(data) < offset + 4 or data[offset:offset + 2] != b"\xbe\xde":
+        return None
+    end = offset + 4 + 4 * int.from_bytes(data[offset + 2:offset + 4], "big")
+    offset += 4
+    while offset < min(end, len(data)):
+        element_id, length = data[offset] >> 4, (data[offset] & 0x0F) + 1
+        if element_id == 0:
+            offset += 1
+            continue
+        if element_id == 15:
+            break
+        if element_id == ext_id:
+            return data[offset + 1:offset + 1 + length]
+        offset += 1 + length
+    return None
+
+
+def ntp_to_unix_ms(ntp):
+    """Convert a 64-bit NTP timestamp (abs-capture-time) to Unix epoch ms."""
+    return ((ntp >> 32) - NTP_UNIX_EPOCH_OFFSET) * 1000.0 + (ntp & 0xFFFFFFFF) * 1000.0 / 2**32
+
+
+class Viewer:
+    def __init__(self, host, port, on_rtp=None, on_data_channel=None, path="/ws"):
+        self.on_rtp = on_rtp
+        self.on_data_channel = on_data_channel
+        self.send_lock = threading.Lock()
+        self.ws = WebSocket(host, port, path)
+
+        self.pipeline = Gst.Pipeline.new(None)
+        self.webrtc = Gst.ElementFactory.make("webrtcbin", None)
+        # No jitter buffer delay, so it does not add to what is being measured
+        self.webrtc.set_property("latency", 0)
+        self.webrtc.set_property("bundle-policy", GstWebRTC.WebRTCBundlePolicy.MAX_BUNDLE)
+        self.webrtc.connect("on-ice-candidate", self._on_ice_candidate)
+        self.webrtc.connect("on-data-channel", self._on_data_channel)
+        self.webrtc.connect("pad-added", self._on_pad_added)
+        self.pipeline.add(self.webrtc)
+        self.pipeline.set_state(Gst.State.PLAYING)
+
+        self.reader = threading.Thread(target=self._read_signaling, daemon=True)
+        self.reader.start()
+
+    def _send(self, message):
+        with self.send_lock:
+            self.ws.send_json(message)
+
+    def _read_signaling(self):
+        while True:
+            try:
+                message = self.ws.receive_json()
+            except (OSError, ConnectionError):
+                return
+            if message is None:
+                return
+            GLib.idle_add(self._on_message, message)
+
+    def _on_message(self, message):
+        if message.get("type") == "offer":
+            _, sdp = GstSdp.SDPMessage.new_from_text(message["sdp"])
+            offer = GstWebRTC.WebRTCSessionDescription.new(GstWebRTC.WebRTCSDPType.OFFER, sdp)
+            promise = Gst.Promise.new_with_change_func(self._on_remote_description_set, None)
+            self.webrtc.emit("set-remote-description", offer, promise)
+        elif message.get("type") == "ice":
+            candidate = message["candidate"]
+            self.webrtc.emit("add-ice-candidate", candidate["sdpMLineIndex"], candidate["candidate"])
+        return GLib.SOURCE_REMOVE
+
+    def _on_remote_description_set(self, promise, _):
+        promise = Gst.Promise.new_with_change_func(self._on_answer_created, None)
+        self.webrtc.emit("create-answer", None, promise)
+
+    def _on_answer_created(self, promise, _):
+        answer = promise.get_reply().get_value("answer")
+        self.webrtc.emit("set-local-description", answer, Gst.Promise.new())
+        self._send({"type": "answer", "sdp": answer.sdp.as_text()})
+
+    def _on_ice_candidate(self, _, mline_index, candidate):
+        self._send({"type": "ice-candidate",
+                    "candidate": {"sdpMLineIndex": mline_index, "candidate": candidate}})
+
+    def _on_data_channel(self, _, channel):
+        if self.on_data_channel is not None:
+            self.on_data_channel(channel)
+
+    def _on_pad_added(self, _, pad):
+        if pad.get_direction() != Gst.PadDirection.SRC:
+            return
+        sink = Gst.ElementFactory.make("fakesink", None)
+        sink.set_property("sync", False)
+        self.pipeline.add(sink)
+        sink.sync_state_with_parent()
+        pad.link(sink.get_static_pad("sink"))
+        if self.on_rtp is not None:
+            pad.add_probe(Gst.PadProbeType.BUFFER, self._on_buffer)
+
+    def _on_buffer(self, pad, info):
+        buffer = info.get_buffer()
+        ok, mapping = buffer.map(Gst.MapFlags.READ)
+        if ok:
+            data = bytes(mapping.data)
+            buffer.unmap(mapping)
+            self.on_rtp(pad, data)
+        return Gst.PadProbeReturn.OK
+
+    def close(self):
+        self.pipeline.set_state(Gst.State.NULL)
+        try:
+            self.ws.close()
+        except OSError:
+            pass
+
+
+def send_data_channel(channel, message):
+    if channel.get_property("ready-state") == GstWebRTC.WebRTCDataChannelState.OPEN:
+        channel.emit("send-string", json.dumps(message))
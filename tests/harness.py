@@ -0,0 +1,124 @@
+"""Helpers shared by the scripts in this directory.
+
+Standard library only: a minimal websocket client for the signaling
+endpoint and a parser for the Prometheus text served on /metrics.
+"""
+
+import base64
+import json
+import os
+import socket
+import struct
+import time
+import urllib.request
+
+
+def fetch_metrics(host, port):
+    """Return {"name{labels}": value} for every sample on /metrics."""
+    with urllib.request.urlopen(f"http://{host}:{port}/metrics", timeout=5) as response:
+        text = response.read().decode()
+
+    metrics = {}
+    for line in text.splitlines():
+        if not line or line.startswith("#"):
+            continue
+        name, _, value = line.rpartition(" ")
+        metrics[name] = float(value)
+    return metrics
+
+
+def metric_sum(metrics, name):
+    """Sum a metric over all of its label sets."""
+    return sum(v for k, v in metrics.items() if k == name or k.startswith(name + "{"))
+
+
+def wait_for(predicate, timeout, interval=0.5):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if predicate():
+            return True
+        time.sleep(interval)
+    return predicate()
+
+
+class WebSocket:
+    """Just enough of RFC 6455 to talk to the signaling server."""
+
+    def __init__(self, host, port, path="/ws", timeout=5):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        key = base64.b64encode(os.urandom(16)).decode()
+        request = (
+            f"GET {path} HTTP/1.1\r\n"
+            f"Host: {host}:{port}\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            f"Sec-WebSocket-Key: {key}\r\n"
+            "Sec-WebSocket-Version: 13\r\n\r\n"
+        )
+        self.sock.sendall(request.encode())
+
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("connection closed during handshake")
+            response += chunk
+        header, _, self.buffer = response.partition(b"\r\n\r\n")
+        if not header.startswith(b"HTTP/1.1 101"):
+            raise ConnectionError(header.split(b"\r\n")[0].decode())
+
+    def _read(self, length):
+        while len(self.buffer) < length:
+            chunk = self.sock.recv(65536)
+            if not chunk:
+                raise ConnectionError("connection closed")
+            self.buffer += chunk
+        data, self.buffer = self.buffer[:length], self.buffer[length:]
+        return data
+
+    def receive(self):
+        """Return the next text message, or None once the server closes."""
+        while True:
+            first, second = self._read(2)
+            opcode = first & 0x0F
+            length = second & 0x7F
+            if length == 126:
+                length = struct.unpack("!H", self._read(2))[0]
+            elif length == 127:
+                length = struct.unpack("!Q", self._read(8))[0]
+            payload = self._read(length)
+
+            if opcode == 0x1:
+                return payload.decode()
+            if opcode == 0x8:
+                return None
+            if opcode == 0x9:
+                self._send_frame(0xA, payload)
+
+    def receive_json(self):
+        message = self.receive()
+        return json.loads(message) if message is not None else None
+
+    def _send_frame(self, opcode, payload):
+        mask = os.urandom(4)
+        header = bytes([0x80 | opcode])
+        if len(payload) < 126:
+            header += bytes([0x80 | len(payload)])
+        elif len(payload) < 65536:
+            header += bytes([0x80 | 126]) + struct.pack("!H", len(payload))
+        else:
+            header += bytes([0x80 | 127]) + struct.pack("!Q", len(payload))
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self.sock.sendall(header + mask + masked)
+
+    def send_json(self, message):
+        self._send_frame(0x1, json.dumps(message).encode())
+
+    def close(self):
+        self._send_frame(0x8, struct.pack("!H", 1000))
+        self.sock.close()
+
+    def abort(self):
+        """Drop the TCP connection with a RST, like a crashed browser tab."""
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+        self.sock.close()
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Loopback check of the glass-to-glass latency measurement.
+
+A headless viewer on the same host reads abs-capture-time from each received
+RTP packet, holds it for a known delay and then reports it over the
+"latency" DataChannel as if the frame were rendered at that moment. The
+server's aggregated p50 must then be the injected delay plus the small,
+real capture → encode → loopback path, and never less than the delay.
+
+    ./Vadd --device=test --latency-stats --connect-interval=0
+    tests/latency_loopback.py --delay-ms 150
+
+Exits non-zero if p50 is outside [delay, delay + tolerance].
+"""
+
+import argparse
+import re
+import sys
+import time
+
+from gi.repository import GLib
+
+from gst_viewer import Viewer, ntp_to_unix_ms, rtp_extension, send_data_channel
+from harness import fetch_metrics
+
+ABS_CAPTURE_TIME_EXT_ID = 3
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--delay-ms", type=float, default=150.0)
+    parser.add_argument("--tolerance-ms", type=float, default=50.0,
+                        help="allowed capture, encode and loopback time on top of the delay")
+    parser.add_argument("--duration", type=float, default=20.0)
+    args = parser.parse_args()
+
+    state = {"channel": None, "last_sample": 0.0, "sent": 0}
+
+    def report(capture_ms):
+        if state["channel"] is not None:
+            send_data_channel(state["channel"], {"capture_time": capture_ms, "render_time": time.time() * 1000.0})
+            state["sent"] += 1
+        return GLib.SOURCE_REMOVE
+
+    def on_rtp(_, data):
+        # About 10 samples per second, like the page
+        now = time.monotonic()
+        if now - state["last_sample"] < 0.1:
+            return
+        extension = rtp_extension(data, ABS_CAPTURE_TIME_EXT_ID)
+        if extension is None or len(extension) < 8:
+            return
+        state["last_sample"] = now
+        capture_ms = ntp_to_unix_ms(int.from_bytes(extension[:8], "big"))
+        GLib.timeout_add(int(args.delay_ms), report, capture_ms)
+
+    def on_data_channel(channel):
+        if channel.get_property("label") == "latency":
+            state["channel"] = channel
+
+    viewer = Viewer(args.host, args.port, on_rtp=on_rtp, on_data_channel=on_data_channel)
+    loop = GLib.MainLoop()
+    GLib.timeout_add_seconds(int(args.duration), loop.quit)
+    loop.run()
+
+    # Our session has the highest id if other viewers are connected
+    p50 = {}
+    for name, value in fetch_metrics(args.host, args.port).items():
+        match = re.match(r'webrtc_glass_to_glass_seconds\{viewer="(\d+)",.*quantile="0\.50"\}', name)
+        if match:
+            p50[int(match.group(1))] = value * 1000.0
+    viewer.close()
+
+    if not p50:
+        print(f"FAIL: no latency reported ({state['sent']} samples sent); "
+              "is the server running with --latency-stats?", file=sys.stderr)
+        return 1
+
+    measured = p50[max(p50)]
+    low, high = args.delay_ms, args.delay_ms + args.tolerance_ms
+    print(f"injected {args.delay_ms:.0f} ms, measured p50 {measured:.1f} ms over {state['sent']} samples")
+    if not low <= measured <= high:
+        print(f"FAIL: p50 outside [{low:.0f}, {high:.0f}] ms", file=sys.stderr)
+        return 1
+    print("PASS")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
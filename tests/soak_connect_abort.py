@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Connect/abort soak test for the viewer session lifecycle.
+
+Runs thousands of websocket sessions that are dropped at different points
+(right after the upgrade, after the offer, after a clean close) and checks
+that process RSS, thread count and tee pad counts return to the idle
+baseline once the reaper has cleaned up.
+
+Start the server with no connection throttling and a viewer limit above the
+concurrency used here, for example:
+
+    ./Vadd --connect-interval=0 --max-viewers=64
+    tests/soak_connect_abort.py --cycles 5000
+
+Exits non-zero if anything does not return to baseline.
+"""
+
+import argparse
+import random
+import sys
+import time
+
+from harness import WebSocket, fetch_metrics, metric_sum, wait_for
+
+
+def one_cycle(host, port, mode):
+    ws = WebSocket(host, port)
+    if mode in ("offer", "close"):
+        message = ws.receive_json()
+        if message is None or message.get("type") != "offer":
+            raise RuntimeError(f"expected an offer, got {message!r}")
+    if mode == "close":
+        ws.close()
+    else:
+        ws.abort()
+
+
+def snapshot(host, port):
+    metrics = fetch_metrics(host, port)
+    return {
+        "rss": metrics["process_resident_memory_bytes"],
+        "threads": metrics["process_threads"],
+        "tee_pads": metric_sum(metrics, "webrtc_tee_src_pads"),
+        "viewers": metrics["webrtc_viewers"],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--cycles", type=int, default=2000)
+    parser.add_argument("--settle", type=float, default=60.0,
+                        help="seconds to wait for the reaper after the last cycle")
+    parser.add_argument("--rss-slack-mib", type=float, default=16.0,
+                        help="allowed RSS growth over baseline (allocator caches)")
+    parser.add_argument("--thread-slack", type=int, default=2,
+                        help="allowed extra threads (GLib worker pools)")
+    args = parser.parse_args()
+
+    # Warm up once so lazily created pools and caches are part of the baseline
+    one_cycle(args.host, args.port, "close")
+    wait_for(lambda: snapshot(args.host, args.port)["viewers"] == 0, args.settle)
+    baseline = snapshot(args.host, args.port)
+    print(f"baseline: {baseline}")
+
+    failures = 0
+    started = time.monotonic()
+    for cycle in range(args.cycles):
+        try:
+            one_cycle(args.host, args.port, random.choice(("upgrade", "offer", "close")))
+        except (OSError, RuntimeError) as error:
+            failures += 1
+            print(f"cycle {cycle}: {error}", file=sys.stderr)
+        if cycle % 500 == 499:
+            print(f"{cycle + 1} cycles, {time.monotonic() - started:.0f} s: {snapshot(args.host, args.port)}")
+
+    wait_for(lambda: snapshot(args.host, args.port)["viewers"] == 0, args.settle)
+    final = snapshot(args.host, args.port)
+    print(f"final:    {final}")
+
+    errors = []
+    if final["viewers"] != 0:
+        errors.append(f"{final['viewers']:.0f} sessions left after {args.settle:.0f} s")
+    if final["tee_pads"] != baseline["tee_pads"]:
+        errors.append(f"tee pads {baseline['tee_pads']:.0f} -> {final['tee_pads']:.0f}")
+    if final["threads"] > baseline["threads"] + args.thread_slack:
+        errors.append(f"threads {baseline['threads']:.0f} -> {final['threads']:.0f}")
+    if final["rss"] > baseline["rss"] + args.rss_slack_mib * 1024 * 1024:
+        errors.append(f"RSS {baseline['rss'] / 2**20:.1f} -> {final['rss'] / 2**20:.1f} MiB")
+    if failures > args.cycles // 100:
+        errors.append(f"{failures} of {args.cycles} cycles failed")
+
+    for error in errors:
+        print(f"FAIL: {error}", file=sys.stderr)
+    if not errors:
+        print(f"PASS: {args.cycles} cycles back to baseline")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())